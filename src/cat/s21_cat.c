@@ -16,8 +16,13 @@ int main(int argc, char *argv[]) {
 
 Flags parse_flags(int argc, char *argv[]) {
   Flags flags = {0};
+  const struct option long_options[] = {
+      {"index", optional_argument, NULL, 'I'},
+      {"lines", required_argument, NULL, 'L'},
+      {NULL, 0, NULL, 0}};
   int opt;
-  while ((opt = getopt(argc, argv, "+bEnstTeEvA")) != -1) {
+  while ((opt = getopt_long(argc, argv, "+bEnstTeEvA", long_options, NULL)) !=
+         -1) {
     switch (opt) {
       case 'b':
         flags.b_flag = 1;
@@ -50,15 +55,57 @@ Flags parse_flags(int argc, char *argv[]) {
         flags.t_flag = 1;
         flags.v_flag = 1;
         break;
+      case 'I':
+        flags.index_flag = 1;
+        if (optarg != NULL) {
+          char *end = optarg;
+          if (isdigit((unsigned char)*optarg)) {
+            flags.index_stride = strtoull(optarg, &end, 10);
+          }
+          if (end == optarg || *end != '\0' || flags.index_stride == 0) {
+            fprintf(stderr, "s21_cat: invalid index stride '%s'\n", optarg);
+            exit(EXIT_FAILURE);
+          }
+        }
+        break;
+      case 'L':
+        if (parse_lines(optarg, &flags) != 0) {
+          fprintf(stderr, "s21_cat: invalid line range '%s'\n", optarg);
+          exit(EXIT_FAILURE);
+        }
+        break;
 
       default:
-        fprintf(stderr, "usage: s21_cat [-bEnstTeEvA] [file ...]\n");
+        fprintf(stderr,
+                "usage: s21_cat [-bEnstTeEvA] [--index[=STRIDE]] "
+                "[--lines=START:END] [file ...]\n");
         exit(EXIT_FAILURE);
     }
   }
   return flags;
 }
 
+// START:END is inclusive and 1-based; either bound may be omitted.
+int parse_lines(const char *arg, Flags *flags) {
+  char *end;
+  flags->line_start = 1;
+  flags->line_end = UINT64_MAX;
+  // strtoull would also take a sign or leading spaces.
+  if (*arg != ':') {
+    if (!isdigit((unsigned char)*arg)) return 1;
+    flags->line_start = strtoull(arg, &end, 10);
+    arg = end;
+  }
+  if (*arg != ':') return 1;
+  arg++;
+  if (*arg != '\0') {
+    if (!isdigit((unsigned char)*arg)) return 1;
+    flags->line_end = strtoull(arg, &end, 10);
+    if (*end != '\0') return 1;
+  }
+  return flags->line_start == 0 || flags->line_end < flags->line_start;
+}
+
 int process_files(int file_count, const char *files[], const Flags *flags) {
   int status = EXIT_SUCCESS;
   for (int i = 0; i < file_count; ++i) {
@@ -71,6 +118,12 @@ int process_files(int file_count, const char *files[], const Flags *flags) {
 }
 
 int process_file(const char *filename, const Flags *flags) {
+  if (flags->index_flag && build_index(filename, flags->index_stride) != 0) {
+    return 1;
+  }
+  if (flags->line_start != 0) return process_lines(filename, flags);
+  if (flags->index_flag) return 0;
+
   FILE *fp = fopen(filename, "r");
   if (fp == NULL) {
     fprintf(stderr, "s21_cat: %s: No such file or directory\n", filename);
@@ -82,38 +135,81 @@ int process_file(const char *filename, const Flags *flags) {
 }
 
 int process_stream(FILE *fp, const Flags *flags) {
+  StreamState state = {'\n', 0, 1, 0};
+  return process_range(fp, flags, &state, UINT64_MAX);
+}
+
+// Seeks to --lines START through the sidecar index (or a plain newline scan
+// when there is none) and resumes numbering as if the whole file was read.
+// Input that cannot be seeked, such as a pipe, is skipped silently instead.
+int process_lines(const char *filename, const Flags *flags) {
+  FILE *fp = fopen(filename, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "s21_cat: %s: No such file or directory\n", filename);
+    return 1;
+  }
+
+  StreamState state = {'\n', 0, 1, 0};
+  ScanState scan;
+  struct stat st;
+  int seeked = 0;
+  if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) &&
+      seek_line(filename, fileno(fp), flags->line_start, &scan) == 0 &&
+      fseeko(fp, (off_t)scan.mark.offset, SEEK_SET) == 0) {
+    seeked = 1;
+    state.blank_line = scan.mark.prev_blank ? 1 : 0;
+    if (flags->b_flag) {
+      state.line_number += scan.mark.nonblank;
+    } else if (flags->s_flag) {
+      state.line_number += scan.lines - scan.mark.squeezed;
+    } else {
+      state.line_number += scan.lines;
+    }
+  }
+
+  if (!seeked) {
+    state.silent = 1;
+    process_range(fp, flags, &state, flags->line_start - 1);
+    state.silent = 0;
+  }
+  int status = process_range(fp, flags, &state,
+                             flags->line_end - flags->line_start + 1);
+  fclose(fp);
+  return status;
+}
+
+// Stops after `lines` input lines, so a range can end mid-file.
+int process_range(FILE *fp, const Flags *flags, StreamState *state,
+                  uint64_t lines) {
   int c;
-  int prev_c = '\n';
-  int line_number = 1;
-  int blank_line = 0;
 
-  while ((c = fgetc(fp)) != EOF) {
+  while (lines != 0 && (c = fgetc(fp)) != EOF) {
+    if (c == '\n') lines--;
+
     if (flags->s_flag) {
       if (c == '\n') {
-        if (prev_c == '\n') {
-          blank_line++;
-          if (blank_line > 1) {
-            prev_c = c;
+        if (state->prev_c == '\n') {
+          state->blank_line++;
+          if (state->blank_line > 1) {
+            state->prev_c = c;
             continue;
           }
         } else {
-          blank_line = 0;
+          state->blank_line = 0;
         }
       } else {
-        blank_line = 0;
+        state->blank_line = 0;
       }
     }
 
-    if (prev_c == '\n') {
-      if (flags->b_flag && c != '\n') {
-        printf("%6d\t", line_number++);
-      } else if (flags->n_flag && !flags->b_flag) {
-        printf("%6d\t", line_number++);
-      }
+    if (state->prev_c == '\n' &&
+        ((flags->b_flag && c != '\n') || (flags->n_flag && !flags->b_flag))) {
+      if (!state->silent) printf("%6" PRIu64 "\t", state->line_number);
+      state->line_number++;
     }
 
-    process_character(c, flags);
-    prev_c = c;
+    if (!state->silent) process_character(c, flags);
+    state->prev_c = c;
   }
 
   return 0;
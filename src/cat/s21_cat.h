@@ -1,23 +1,44 @@
 #ifndef S21_CAT_H
 #define S21_CAT_H
 
+#include <ctype.h>
+#include <getopt.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include "s21_cat_index.h"
+
 typedef struct {
-  int b_flag;  // -b: Number non-blank output lines
-  int e_flag;  // -e or -E: Display $ at end of each line
-  int n_flag;  // -n: Number all output lines
-  int s_flag;  // -s: Squeeze multiple adjacent blank lines
-  int t_flag;  // -t or -T: Display TAB characters as ^I
-  int v_flag;  // -v: Use ^ and M- notation, except for LFD and TAB
+  int b_flag;             // -b: Number non-blank output lines
+  int e_flag;             // -e or -E: Display $ at end of each line
+  int n_flag;             // -n: Number all output lines
+  int s_flag;             // -s: Squeeze multiple adjacent blank lines
+  int t_flag;             // -t or -T: Display TAB characters as ^I
+  int v_flag;             // -v: Use ^ and M- notation, except for LFD and TAB
+  int index_flag;         // --index[=STRIDE]: Build or extend the sidecar
+  uint64_t index_stride;  // Lines between sampled marks, 0 keeps existing
+  uint64_t line_start;    // --lines=START:END: First line to print, 0 if all
+  uint64_t line_end;      // Last line to print, UINT64_MAX for EOF
 } Flags;
 
+typedef struct {
+  int prev_c;
+  int blank_line;
+  uint64_t line_number;
+  int silent;  // Track numbering without printing anything
+} StreamState;
+
 Flags parse_flags(int argc, char *argv[]);
 int process_files(int file_count, const char *files[], const Flags *flags);
 int process_file(const char *filename, const Flags *flags);
 int process_stream(FILE *fp, const Flags *flags);
+int process_range(FILE *fp, const Flags *flags, StreamState *state,
+                  uint64_t lines);
+int process_lines(const char *filename, const Flags *flags);
+int parse_lines(const char *arg, Flags *flags);
 void process_character(int c, const Flags *flags);
 int is_non_printable(int c);
 
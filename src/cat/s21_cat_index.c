@@ -0,0 +1,213 @@
+#include "s21_cat_index.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static char *index_path(const char *filename) {
+  size_t len = strlen(filename);
+  char *path = malloc(len + sizeof(INDEX_SUFFIX));
+  if (path != NULL) {
+    memcpy(path, filename, len);
+    memcpy(path + len, INDEX_SUFFIX, sizeof(INDEX_SUFFIX));
+  }
+  return path;
+}
+
+static void count_line(ScanState *state, size_t newline, uint64_t stride,
+                       FILE *marks) {
+  if (newline == state->mark.offset) {
+    if (state->mark.prev_blank) state->mark.squeezed++;
+    state->mark.prev_blank = 1;
+  } else {
+    state->mark.nonblank++;
+    state->mark.prev_blank = 0;
+  }
+  state->mark.offset = newline + 1;
+  state->lines++;
+  if (marks != NULL && state->lines % stride == 0) {
+    fwrite(&state->mark, sizeof(LineMark), 1, marks);
+  }
+}
+
+void scan_lines(const unsigned char *buf, size_t len, ScanState *state,
+                uint64_t limit, uint64_t stride, FILE *marks) {
+  size_t pos = state->mark.offset;
+#ifdef __SSE2__
+  // Compare 16 bytes at a time and walk the newline bits of each block.
+  const __m128i nl = _mm_set1_epi8('\n');
+  while (pos + 16 <= len && state->lines < limit) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(buf + pos));
+    unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, nl));
+    while (mask != 0 && state->lines < limit) {
+      count_line(state, pos + (size_t)__builtin_ctz(mask), stride, marks);
+      mask &= mask - 1;
+    }
+    pos += 16;
+  }
+#endif
+  while (pos < len && state->lines < limit) {
+    const unsigned char *nl_ptr = memchr(buf + pos, '\n', len - pos);
+    if (nl_ptr == NULL) break;
+    count_line(state, (size_t)(nl_ptr - buf), stride, marks);
+    pos = state->mark.offset;
+  }
+}
+
+// Scans [state->mark.offset, size) of an open file through a private mapping.
+static int scan_file(int fd, size_t size, ScanState *state, uint64_t limit,
+                     uint64_t stride, FILE *marks) {
+  if (state->mark.offset >= size) return 0;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) return 1;
+  madvise(map, size, MADV_SEQUENTIAL);
+  scan_lines(map, size, state, limit, stride, marks);
+  munmap(map, size);
+  return 0;
+}
+
+// FNV-1a of the bytes just before offset, so a sidecar is not reused for a
+// file that was truncated or rewritten and then grew past the old tail.
+static uint64_t tail_checksum(int fd, uint64_t offset) {
+  unsigned char buf[INDEX_CHECK_BYTES];
+  uint64_t start = offset > sizeof(buf) ? offset - sizeof(buf) : 0;
+  ssize_t len = pread(fd, buf, (size_t)(offset - start), (off_t)start);
+  uint64_t hash = 14695981039346656037ULL;
+  for (ssize_t i = 0; i < len; i++) {
+    hash = (hash ^ buf[i]) * 1099511628211ULL;
+  }
+  return len == (ssize_t)(offset - start) ? hash : ~hash;
+}
+
+// Checks that a sidecar header describes the open file it is used with.
+static int header_matches(const IndexHeader *header, int fd,
+                          const struct stat *st) {
+  return memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) == 0 &&
+         header->stride != 0 &&
+         header->marks == header->lines / header->stride + 1 &&
+         header->device == (uint64_t)st->st_dev &&
+         header->inode == (uint64_t)st->st_ino &&
+         header->tail.offset <= (uint64_t)st->st_size &&
+         header->checksum == tail_checksum(fd, header->tail.offset);
+}
+
+static int read_header(FILE *fp, IndexHeader *header, uint64_t stride, int fd,
+                       const struct stat *st) {
+  return fread(header, sizeof(IndexHeader), 1, fp) == 1 &&
+         header_matches(header, fd, st) &&
+         (stride == 0 || header->stride == stride);
+}
+
+int build_index(const char *filename, uint64_t stride) {
+  int fd = open(filename, O_RDONLY);
+  if (fd == -1) {
+    fprintf(stderr, "s21_cat: %s: No such file or directory\n", filename);
+    return 1;
+  }
+  struct stat st;
+  char *path = index_path(filename);
+  if (fstat(fd, &st) == -1 || path == NULL) {
+    close(fd);
+    free(path);
+    return 1;
+  }
+
+  IndexHeader header;
+  ScanState state = {0};
+  FILE *fp = fopen(path, "r+b");
+  if (fp != NULL && read_header(fp, &header, stride, fd, &st) &&
+      fseeko(fp,
+             (off_t)(sizeof(IndexHeader) + header.marks * sizeof(LineMark)),
+             SEEK_SET) == 0) {
+    // The file only grew: resume from the first line not yet covered.
+    state.mark = header.tail;
+    state.lines = header.lines;
+  } else {
+    if (fp != NULL) fclose(fp);
+    fp = fopen(path, "w+b");
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.stride = stride != 0 ? stride : INDEX_DEFAULT_STRIDE;
+    if (fp != NULL) {
+      fwrite(&header, sizeof(IndexHeader), 1, fp);
+      fwrite(&state.mark, sizeof(LineMark), 1, fp);
+    }
+  }
+
+  int status = 1;
+  if (fp != NULL) {
+    status = scan_file(fd, (size_t)st.st_size, &state, UINT64_MAX,
+                       header.stride, fp);
+    header.lines = state.lines;
+    header.marks = state.lines / header.stride + 1;
+    header.tail = state.mark;
+    header.device = (uint64_t)st.st_dev;
+    header.inode = (uint64_t)st.st_ino;
+    header.checksum = tail_checksum(fd, state.mark.offset);
+    if (fseeko(fp, 0, SEEK_SET) != 0) status = 1;
+    fwrite(&header, sizeof(IndexHeader), 1, fp);
+    if (ferror(fp)) status = 1;
+    if (fclose(fp) != 0) status = 1;
+  }
+  if (status != 0) {
+    fprintf(stderr, "s21_cat: %s: Cannot write index\n", path);
+  }
+  free(path);
+  close(fd);
+  return status;
+}
+
+// Starts from the nearest sampled mark of a valid sidecar, if there is one.
+static void load_mark(const char *filename, uint64_t line, int source,
+                      const struct stat *source_st, ScanState *state) {
+  char *path = index_path(filename);
+  int fd = path != NULL ? open(path, O_RDONLY) : -1;
+  struct stat st;
+  if (fd != -1 && fstat(fd, &st) == 0 &&
+      (size_t)st.st_size >= sizeof(IndexHeader)) {
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED) {
+      const IndexHeader *header = map;
+      const LineMark *marks = (const LineMark *)(header + 1);
+      if (header_matches(header, source, source_st) &&
+          (size_t)st.st_size >=
+              sizeof(IndexHeader) + header->marks * sizeof(LineMark)) {
+        if (line - 1 >= header->lines) {
+          state->mark = header->tail;
+          state->lines = header->lines;
+        } else {
+          uint64_t i = (line - 1) / header->stride;
+          if (i < header->marks) {
+            state->mark = marks[i];
+            state->lines = i * header->stride;
+          }
+        }
+      }
+      munmap(map, (size_t)st.st_size);
+    }
+  }
+  if (fd != -1) close(fd);
+  free(path);
+}
+
+// Finds the start of a line in the regular file open as fd.
+int seek_line(const char *filename, int fd, uint64_t line, ScanState *state) {
+  struct stat st;
+  int status = fstat(fd, &st) == -1;
+  memset(state, 0, sizeof(ScanState));
+  if (status == 0) {
+    size_t size = (size_t)st.st_size;
+    load_mark(filename, line, fd, &st, state);
+    status = scan_file(fd, size, state, line - 1, 0, NULL);
+    // Past the last line: nothing left to print.
+    if (state->lines < line - 1) state->mark.offset = size;
+  }
+  return status;
+}
@@ -0,0 +1,45 @@
+#ifndef S21_CAT_INDEX_H
+#define S21_CAT_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define INDEX_SUFFIX ".s21idx"
+#define INDEX_MAGIC "S21CIDX2"
+#define INDEX_DEFAULT_STRIDE 4096
+#define INDEX_CHECK_BYTES 256
+
+// State of the input at the start of a line. Enough to resume -n, -b and
+// -s exactly as if every preceding line had been streamed.
+typedef struct {
+  uint64_t offset;      // Byte offset of the line start
+  uint64_t nonblank;    // Non-blank lines before it (-b numbering)
+  uint64_t squeezed;    // Blank lines before it dropped by -s
+  uint64_t prev_blank;  // 1 if the preceding line is blank
+} LineMark;
+
+// Sidecar file layout: this header followed by one LineMark for every
+// stride-th line (mark i describes the start of line i * stride + 1).
+typedef struct {
+  char magic[8];      // INDEX_MAGIC, not NUL-terminated
+  uint64_t device;    // st_dev of the indexed file
+  uint64_t inode;     // st_ino of the indexed file
+  uint64_t checksum;  // FNV-1a of the INDEX_CHECK_BYTES before tail.offset
+  uint64_t stride;    // Lines between two sampled marks
+  uint64_t lines;     // Complete lines covered by the index
+  uint64_t marks;     // Number of LineMark records after the header
+  LineMark tail;      // Mark for the first line not covered yet
+} IndexHeader;
+
+typedef struct {
+  LineMark mark;   // Current line start
+  uint64_t lines;  // Complete lines consumed so far
+} ScanState;
+
+int build_index(const char *filename, uint64_t stride);
+int seek_line(const char *filename, int fd, uint64_t line, ScanState *state);
+void scan_lines(const unsigned char *buf, size_t len, ScanState *state,
+                uint64_t limit, uint64_t stride, FILE *marks);
+
+#endif  // S21_CAT_INDEX_H
@@ -56,10 +56,20 @@ declare -a tests=(
     "-e $TEST_DIR/nonexistent.txt"
 )
 
+# Line ranges have no cat counterpart: compare with a full cat cut by sed
+declare -a range_tests=(
+    "-n --lines=3:5 $TEST_DIR/test1.txt|-n $TEST_DIR/test1.txt | sed -n 3,5p"
+    "-b --lines=4: $TEST_DIR/test1.txt|-b $TEST_DIR/test1.txt | sed -n '4,\$p'"
+    "-e --lines=:2 $TEST_DIR/test2.txt|-e $TEST_DIR/test2.txt | sed -n 1,2p"
+    "-n --lines=6:9 $TEST_DIR/test1.txt|-n $TEST_DIR/test1.txt | sed -n 6,9p"
+    "--index=2 -n --lines=5:6 $TEST_DIR/test1.txt|-n $TEST_DIR/test1.txt | sed -n 5,6p"
+    "-b --lines=5:7 $TEST_DIR/test1.txt|-b $TEST_DIR/test1.txt | sed -n 5,7p"
+)
+
 # Function to run a test case
 run_test() {
     local test_command="$1"
-    local cat_command="$CAT $test_command"
+    local cat_command="$CAT ${2:-$test_command}"
     local s21_cat_command="$S21_CAT $test_command"
 
     # Run the commands and capture outputs
@@ -93,6 +103,51 @@ run_test() {
 for test_case in "${tests[@]}"; do
     run_test "$test_case"
 done
+for test_case in "${range_tests[@]}"; do
+    run_test "${test_case%%|*}" "${test_case#*|}"
+done
+
+# Sidecar index: lines longer than one 16-byte scan block, a stride smaller
+# than the line count, growth, a stride change, a shrink and a rewrite
+make_lines() {
+    for i in $(seq "$1" "$2"); do
+        if [ $((i % 5)) -lt 2 ]; then
+            echo
+        else
+            printf 'line %d %s\n' "$i" "$(printf '%*s' $((i % 40 + 16)) '' | tr ' ' '=')"
+        fi
+    done
+}
+INDEXED="$TEST_DIR/indexed.txt"
+rm -f "$INDEXED.s21idx"
+make_lines 1 60 > "$INDEXED"
+$S21_CAT --index=4 "$INDEXED"
+run_test "-n --lines=20:45 $INDEXED" "-n $INDEXED | sed -n 20,45p"
+# Grow with a partial last line, before and after extending the index
+make_lines 61 90 >> "$INDEXED"
+printf 'partial' >> "$INDEXED"
+run_test "-b --lines=55:91 $INDEXED" "-b $INDEXED | sed -n 55,91p"
+$S21_CAT --index "$INDEXED"
+run_test "-n --lines=58: $INDEXED" "-n $INDEXED | sed -n '58,\$p'"
+# Complete the partial line and keep growing
+printf ' line\n' >> "$INDEXED"
+make_lines 92 120 >> "$INDEXED"
+$S21_CAT --index "$INDEXED"
+run_test "-e -n --lines=88:120 $INDEXED" "-e -n $INDEXED | sed -n 88,120p"
+run_test "-b --lines=91:93 $INDEXED" "-b $INDEXED | sed -n 91,93p"
+# A different stride rebuilds the index
+$S21_CAT --index=9 "$INDEXED"
+run_test "-b --lines=30:100 $INDEXED" "-b $INDEXED | sed -n 30,100p"
+# A shrunk file ignores the stale index until it is rebuilt
+make_lines 1 40 > "$INDEXED"
+run_test "-n --lines=10:40 $INDEXED" "-n $INDEXED | sed -n 10,40p"
+$S21_CAT --index "$INDEXED"
+run_test "-b --lines=12:39 $INDEXED" "-b $INDEXED | sed -n 12,39p"
+# A rewrite that grows past the old tail must not reuse stale marks
+make_lines 500 700 > "$INDEXED"
+run_test "-n --lines=55:56 $INDEXED" "-n $INDEXED | sed -n 55,56p"
+$S21_CAT --index "$INDEXED"
+run_test "-n --lines=150:190 $INDEXED" "-n $INDEXED | sed -n 150,190p"
 
 # Summary
 echo -e "\n========================================"
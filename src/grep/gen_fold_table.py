@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Generates s21_grep_fold_table.h from the Unicode CaseFolding.txt.
+
+Usage: python3 gen_fold_table.py CaseFolding.txt > s21_grep_fold_table.h
+
+Only the C (common) and S (simple) entries are kept, which together form
+the simple case folding. ASCII is skipped because s21_grep_fold.c folds it
+with its own lookup table. Consecutive entries with the same delta are
+merged into ranges; a step of 2 covers upper/lower-case pairs that alternate.
+"""
+
+import sys
+
+
+def load_folds(path):
+    folds = {}
+    version = ""
+    with open(path, encoding="utf-8") as source:
+        for line in source:
+            if line.startswith("# CaseFolding-"):
+                version = line[2:].strip()
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            code, status, mapping = [field.strip() for field in line.split(";")[:3]]
+            if status in ("C", "S"):
+                folds[int(code, 16)] = int(mapping, 16)
+    return folds, version
+
+
+def utf8_length(code_point):
+    return len(chr(code_point).encode("utf-8"))
+
+
+def build_ranges(folds):
+    ranges = []
+    for code in sorted(code for code in folds if code >= 0x80):
+        delta = folds[code] - code
+        if ranges:
+            first, last, last_delta, step = ranges[-1]
+            if last_delta == delta:
+                if code == last + 1 and (step == 1 or first == last):
+                    ranges[-1] = [first, code, delta, 1]
+                    continue
+                # The skipped code point must not fold, or the ranges overlap.
+                if code == last + 2 and (step == 2 or first == last) and \
+                        code - 1 not in folds:
+                    ranges[-1] = [first, code, delta, 2]
+                    continue
+        ranges.append([code, code, delta, 1])
+    return ranges
+
+
+def check(folds, ranges):
+    expanded = {}
+    previous_last = -1
+    for first, last, delta, step in ranges:
+        if first <= previous_last:
+            sys.exit("overlapping ranges at U+%04X" % first)
+        previous_last = last
+        for code in range(first, last + 1, step):
+            expanded[code] = code + delta
+    if expanded != {code: fold for code, fold in folds.items() if code >= 0x80}:
+        sys.exit("range table does not reproduce CaseFolding.txt")
+    for code, fold in expanded.items():
+        # foldLine sizes its buffer for at most twice the original length.
+        if utf8_length(fold) > 2 * utf8_length(code):
+            sys.exit("fold of U+%04X more than doubles its length" % code)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: gen_fold_table.py CaseFolding.txt")
+    folds, version = load_folds(sys.argv[1])
+    ranges = build_ranges(folds)
+    check(folds, ranges)
+
+    print("/* Generated by gen_fold_table.py from %s. Do not edit. */"
+          % (version or "CaseFolding.txt"))
+    print("#ifndef S21_GREP_FOLD_TABLE_H")
+    print("#define S21_GREP_FOLD_TABLE_H")
+    print()
+    print('#include "s21_grep_fold.h"')
+    print()
+    print("/* Unicode simple case folding (status C and S) above ASCII, sorted")
+    print(" * by first code point. */")
+    print("static const FoldRange foldRanges[] = {")
+    for first, last, delta, step in ranges:
+        print("    {0x%04X, 0x%04X, %d, %d}," % (first, last, delta, step))
+    print("};")
+    print()
+    print("#endif /* S21_GREP_FOLD_TABLE_H */")
+
+
+if __name__ == "__main__":
+    main()
@@ -7,6 +7,7 @@ int main(int argc, char *argv[]) {
   PatternNode *patterns = NULL;
   int exitCode = 0;
 
+  initializeLocale();
   if (!initializeArgumentTypes(&args)) {
     fprintf(stderr, "Memory allocation error!\n");
     return 1;
@@ -28,6 +29,17 @@ int main(int argc, char *argv[]) {
   return exitCode;
 }
 
+/* Makes regular expressions match UTF-8 characters rather than bytes. The
+ * case folding assumes UTF-8, so C.UTF-8 is used when the environment
+ * locale has another encoding. */
+int initializeLocale(void) {
+  const char *locale = setlocale(LC_CTYPE, "");
+  if (locale == NULL || strcmp(nl_langinfo(CODESET), "UTF-8") != 0) {
+    locale = setlocale(LC_CTYPE, "C.UTF-8");
+  }
+  return locale != NULL;
+}
+
 /* Initializes the argument types array. */
 int initializeArgumentTypes(ProgramArguments *args) {
   args->argumentTypes = (int *)calloc((size_t)args->argumentCount, sizeof(int));
@@ -146,9 +158,8 @@ int parsePatterns(ProgramArguments *args, Flags *flags,
   /* Load patterns from '-e' flags and standard patterns. */
   for (int i = 1; i < args->argumentCount && success; i++) {
     if (args->argumentTypes[i] == ARG_PATTERN) {
-      regex_t regexCompiled;
-      int regexFlags = REG_EXTENDED | (flags->flagI ? REG_ICASE : 0);
-      if (regcomp(&regexCompiled, args->argumentValues[i], regexFlags) != 0) {
+      PatternNode compiled;
+      if (!compilePattern(args->argumentValues[i], flags, &compiled)) {
         fprintf(stderr, "grep: invalid regular expression: %s\n",
                 args->argumentValues[i]);
         success = 0;
@@ -157,9 +168,12 @@ int parsePatterns(ProgramArguments *args, Flags *flags,
         if (newNode == NULL) {
           fprintf(stderr, "Memory allocation error!\n");
           success = 0;
-          regfree(&regexCompiled);
+          regfree(&compiled.regexCompiled);
+          if (compiled.isAscii) {
+            regfree(&compiled.asciiCompiled);
+          }
         } else {
-          newNode->regexCompiled = regexCompiled;
+          *newNode = compiled;
           newNode->next = patternList;
           patternList = newNode;
         }
@@ -185,6 +199,37 @@ int parsePatterns(ProgramArguments *args, Flags *flags,
   return success;
 }
 
+/* Compiles a pattern. With '-i' the pattern is case-folded instead of using
+ * REG_ICASE, so it matches lines folded by foldLine. An ASCII pattern is
+ * also compiled in the C locale: on a pure-ASCII line it matches exactly
+ * like the multibyte version, without the multibyte handling. */
+int compilePattern(const char *pattern, const Flags *flags, PatternNode *node) {
+  int success = 0;
+  char *folded = flags->flagI ? foldPattern(pattern) : NULL;
+  const char *expression = flags->flagI ? folded : pattern;
+
+  if (expression != NULL &&
+      regcomp(&node->regexCompiled, expression, REG_EXTENDED) == 0) {
+    size_t length = strlen(expression);
+    locale_t asciiLocale = newlocale(LC_CTYPE_MASK, "C", (locale_t)0);
+    node->isAscii =
+        asciiLocale != (locale_t)0 &&
+        asciiPrefixLength((const unsigned char *)expression, length) == length;
+    if (node->isAscii) {
+      locale_t previous = uselocale(asciiLocale);
+      node->isAscii =
+          regcomp(&node->asciiCompiled, expression, REG_EXTENDED) == 0;
+      uselocale(previous);
+    }
+    if (asciiLocale != (locale_t)0) {
+      freelocale(asciiLocale);
+    }
+    success = 1;
+  }
+  free(folded);
+  return success;
+}
+
 /* Loads patterns from a file specified with '-f' flag. */
 int loadPatternsFromFile(const char *patternFilePath, Flags *flags,
                          PatternNode **patterns) {
@@ -205,9 +250,8 @@ int loadPatternsFromFile(const char *patternFilePath, Flags *flags,
     if (newlineChar) {
       *newlineChar = '\0';
     }
-    regex_t regexCompiled;
-    int regexFlags = REG_EXTENDED | (flags->flagI ? REG_ICASE : 0);
-    if (regcomp(&regexCompiled, line, regexFlags) != 0) {
+    PatternNode compiled;
+    if (!compilePattern(line, flags, &compiled)) {
       fprintf(stderr, "grep: invalid regular expression: %s\n", line);
       success = 0;
     } else {
@@ -215,9 +259,12 @@ int loadPatternsFromFile(const char *patternFilePath, Flags *flags,
       if (newNode == NULL) {
         fprintf(stderr, "Memory allocation error!\n");
         success = 0;
-        regfree(&regexCompiled);
+        regfree(&compiled.regexCompiled);
+        if (compiled.isAscii) {
+          regfree(&compiled.asciiCompiled);
+        }
       } else {
-        newNode->regexCompiled = regexCompiled;
+        *newNode = compiled;
         newNode->next = *patterns;
         *patterns = newNode;
       }
@@ -235,6 +282,9 @@ void freePatterns(PatternNode *patterns) {
   while (current != NULL) {
     PatternNode *next = current->next;
     regfree(&current->regexCompiled);
+    if (current->isAscii) {
+      regfree(&current->asciiCompiled);
+    }
     free(current);
     current = next;
   }
@@ -305,6 +355,7 @@ int processFile(const char *filePath, const Flags *flags,
     }
 
     free(lineInfo.lineContent);
+    freeFoldBuffer(&lineInfo.fold);
     fclose(file);
   }
 
@@ -320,6 +371,7 @@ int readLine(FILE *file, LineInfo *lineInfo) {
     if (newlineChar) {
       *newlineChar = '\0';
     }
+    lineInfo->contentLength = strlen(lineInfo->lineContent);
     lineInfo->lineNumber++;
     lineInfo->isMatch = 0;
     return 1;
@@ -348,20 +400,30 @@ void processLine(LineInfo *lineInfo, const Flags *flags,
 int matchLine(LineInfo *lineInfo, const Flags *flags, PatternNode *patterns) {
   int isMatched = 0;
   PatternNode *current = patterns;
+  const char *subject = lineInfo->lineContent;
+  size_t length = lineInfo->contentLength;
+
+  if (flags->flagI) {
+    if (!foldLine(&lineInfo->fold, lineInfo->lineContent,
+                  lineInfo->contentLength)) {
+      fprintf(stderr, "Memory allocation error!\n");
+      return 0;
+    }
+    subject = lineInfo->fold.text;
+    length = lineInfo->fold.length;
+  }
+  int isAscii =
+      asciiPrefixLength((const unsigned char *)subject, length) == length;
 
   while (current != NULL && !isMatched) {
-    regex_t *regex = &current->regexCompiled;
+    regex_t *regex = isAscii && current->isAscii ? &current->asciiCompiled
+                                                 : &current->regexCompiled;
     regmatch_t match;
 
     if (flags->flagO) {
-      const char *currentPosition = lineInfo->lineContent;
-      while (regexec(regex, currentPosition, 1, &match, 0) == 0) {
-        isMatched = 1;
-        printMatchingPart(lineInfo, flags, &match);
-        currentPosition += match.rm_eo;
-      }
+      isMatched = matchParts(lineInfo, flags, regex, subject, length);
     } else {
-      if (regexec(regex, lineInfo->lineContent, 1, &match, 0) == 0) {
+      if (regexec(regex, subject, 1, &match, 0) == 0) {
         isMatched = 1;
       }
     }
@@ -371,6 +433,39 @@ int matchLine(LineInfo *lineInfo, const Flags *flags, PatternNode *patterns) {
   return isMatched;
 }
 
+/* Prints every match of the '-o' flag. Matches end on character boundaries
+ * because the regex is character-aware; empty matches advance by one
+ * character. */
+int matchParts(const LineInfo *lineInfo, const Flags *flags,
+               const regex_t *regex, const char *subject, size_t length) {
+  const unsigned char *text = (const unsigned char *)subject;
+  int isMatched = 0;
+  int execFlags = 0;
+  size_t offset = 0;
+  regmatch_t match;
+
+  while (offset <= length &&
+         regexec(regex, subject + offset, 1, &match, execFlags) == 0) {
+    size_t start = offset + (size_t)match.rm_so;
+    size_t end = offset + (size_t)match.rm_eo;
+    isMatched = 1;
+    if (end > start) {
+      regmatch_t part = {(regoff_t)start, (regoff_t)end};
+      if (flags->flagI) {
+        part.rm_so = (regoff_t)originalOffset(&lineInfo->fold, start);
+        part.rm_eo = (regoff_t)originalOffset(&lineInfo->fold, end);
+      }
+      printMatchingPart(lineInfo, flags, &part);
+      offset = end;
+    } else {
+      offset = start + utf8CharLength(text + start, length - start);
+    }
+    execFlags = REG_NOTBOL;
+  }
+
+  return isMatched;
+}
+
 /* Prints a matched line according to the flags. */
 void printMatchedLine(const LineInfo *lineInfo, const Flags *flags) {
   if (flags->flagO) {
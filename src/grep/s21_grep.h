@@ -1,12 +1,16 @@
 #ifndef S21_GREP_H
 #define S21_GREP_H
 
+#include <langinfo.h>
+#include <locale.h>
 #include <regex.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 
+#include "s21_grep_fold.h"
+
 #define HANDLE_PATTERN_FLAG(flag, flagField, errorType, type)                 \
   do {                                                                        \
     flags->flagField = 1;                                                     \
@@ -62,27 +66,33 @@ typedef struct {
 
 /* Structure to hold information about the current line being processed. */
 typedef struct {
-  char *filePath;    /* Path of the file. */
-  char *lineContent; /* Content of the current line. */
-  size_t lineLength; /* Length of the line buffer. */
-  int lineNumber;    /* Current line number in the file. */
-  int isMatch;       /* Indicates if the current line matches the pattern. */
-  int matchCount;    /* Total number of matches found. */
+  char *filePath;       /* Path of the file. */
+  char *lineContent;    /* Content of the current line. */
+  size_t lineLength;    /* Length of the line buffer. */
+  size_t contentLength; /* Length of the line without the newline. */
+  FoldBuffer fold;      /* Case-folded line for the '-i' flag. */
+  int lineNumber;       /* Current line number in the file. */
+  int isMatch;          /* Indicates if the current line matches the pattern. */
+  int matchCount;       /* Total number of matches found. */
 } LineInfo;
 
 /* Structure to hold compiled regular expressions. */
 typedef struct PatternNode {
   regex_t regexCompiled;    /* Compiled regular expression. */
+  regex_t asciiCompiled;    /* Same expression compiled in the C locale. */
+  int isAscii;              /* asciiCompiled is set: the pattern is ASCII. */
   struct PatternNode *next; /* Pointer to the next pattern node. */
 } PatternNode;
 
 /* Function prototypes. */
+int initializeLocale(void);
 int initializeArgumentTypes(ProgramArguments *args);
 int validateArguments(const ProgramArguments *args, const Flags *flags);
 int parseFlags(ProgramArguments *args, Flags *flags);
 void processFlag(ProgramArguments *args, Flags *flags, char *flagString,
                  int *index);
 int parsePatterns(ProgramArguments *args, Flags *flags, PatternNode **patterns);
+int compilePattern(const char *pattern, const Flags *flags, PatternNode *node);
 int loadPatternsFromFile(const char *patternFilePath, Flags *flags,
                          PatternNode **patterns);
 void freePatterns(PatternNode *patterns);
@@ -93,6 +103,8 @@ int processFile(const char *filePath, const Flags *flags,
 int readLine(FILE *file, LineInfo *lineInfo);
 void processLine(LineInfo *lineInfo, const Flags *flags, PatternNode *patterns);
 int matchLine(LineInfo *lineInfo, const Flags *flags, PatternNode *patterns);
+int matchParts(const LineInfo *lineInfo, const Flags *flags,
+               const regex_t *regex, const char *subject, size_t length);
 void printMatchedLine(const LineInfo *lineInfo, const Flags *flags);
 void printMatchingPart(const LineInfo *lineInfo, const Flags *flags,
                        const regmatch_t *match);
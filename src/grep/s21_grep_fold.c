@@ -0,0 +1,342 @@
+#include "s21_grep_fold.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "s21_grep_fold_table.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* ASCII case folding table: upper-case letters map to lower-case. */
+static const unsigned char asciiFold[256] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+    0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+    0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+    0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+    0x40, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+    0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+    0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67,
+    0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+    0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77,
+    0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x7F,
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97,
+    0x98, 0x99, 0x9A, 0x9B, 0x9C, 0x9D, 0x9E, 0x9F,
+    0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7,
+    0xA8, 0xA9, 0xAA, 0xAB, 0xAC, 0xAD, 0xAE, 0xAF,
+    0xB0, 0xB1, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7,
+    0xB8, 0xB9, 0xBA, 0xBB, 0xBC, 0xBD, 0xBE, 0xBF,
+    0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7,
+    0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF,
+    0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7,
+    0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDE, 0xDF,
+    0xE0, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7,
+    0xE8, 0xE9, 0xEA, 0xEB, 0xEC, 0xED, 0xEE, 0xEF,
+    0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+    0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF,
+};
+
+/* Returns the number of leading bytes below 0x80. */
+size_t asciiPrefixLength(const unsigned char *text, size_t length) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= length; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i *)(text + i));
+    unsigned mask = (unsigned)_mm_movemask_epi8(block);
+    if (mask != 0) {
+      return i + (size_t)__builtin_ctz(mask);
+    }
+  }
+#endif
+  while (i < length && text[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
+/* Decodes one UTF-8 sequence. Invalid bytes decode as themselves with a
+ * length of 1 and a code point of UINT32_MAX. */
+static size_t decodeUtf8(const unsigned char *text, size_t length,
+                         uint32_t *codePoint) {
+  size_t size = 1;
+  uint32_t value = UINT32_MAX;
+  if (text[0] < 0x80) {
+    value = text[0];
+  } else if (text[0] >= 0xC2 && text[0] <= 0xDF) {
+    size = 2;
+    value = text[0] & 0x1Fu;
+  } else if (text[0] >= 0xE0 && text[0] <= 0xEF) {
+    size = 3;
+    value = text[0] & 0x0Fu;
+  } else if (text[0] >= 0xF0 && text[0] <= 0xF4) {
+    size = 4;
+    value = text[0] & 0x07u;
+  }
+  if (size > length) {
+    size = 1;
+    value = UINT32_MAX;
+  }
+  for (size_t i = 1; i < size && value != UINT32_MAX; i++) {
+    if ((text[i] & 0xC0) != 0x80) {
+      size = 1;
+      value = UINT32_MAX;
+    } else {
+      value = (value << 6) | (text[i] & 0x3Fu);
+    }
+  }
+  /* Reject overlong forms, surrogates and values past U+10FFFF. */
+  if ((size == 3 && (value < 0x800 || (value >= 0xD800 && value <= 0xDFFF))) ||
+      (size == 4 && (value < 0x10000 || value > 0x10FFFF))) {
+    size = 1;
+    value = UINT32_MAX;
+  }
+  *codePoint = value;
+  return size;
+}
+
+static size_t encodeUtf8(uint32_t codePoint, unsigned char *out) {
+  size_t size = 1;
+  if (codePoint < 0x80) {
+    out[0] = (unsigned char)codePoint;
+  } else if (codePoint < 0x800) {
+    out[0] = (unsigned char)(0xC0 | (codePoint >> 6));
+    out[1] = (unsigned char)(0x80 | (codePoint & 0x3F));
+    size = 2;
+  } else if (codePoint < 0x10000) {
+    out[0] = (unsigned char)(0xE0 | (codePoint >> 12));
+    out[1] = (unsigned char)(0x80 | ((codePoint >> 6) & 0x3F));
+    out[2] = (unsigned char)(0x80 | (codePoint & 0x3F));
+    size = 3;
+  } else {
+    out[0] = (unsigned char)(0xF0 | (codePoint >> 18));
+    out[1] = (unsigned char)(0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = (unsigned char)(0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = (unsigned char)(0x80 | (codePoint & 0x3F));
+    size = 4;
+  }
+  return size;
+}
+
+static uint32_t foldCodePoint(uint32_t codePoint) {
+  size_t low = 0;
+  size_t high = sizeof(foldRanges) / sizeof(foldRanges[0]);
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    const FoldRange *range = &foldRanges[middle];
+    if (codePoint < range->first) {
+      high = middle;
+    } else if (codePoint > range->last) {
+      low = middle + 1;
+    } else {
+      if ((codePoint - range->first) % range->step == 0) {
+        codePoint = (uint32_t)((int32_t)codePoint + range->delta);
+      }
+      break;
+    }
+  }
+  return codePoint;
+}
+
+/* Folds the character at text and writes it to out. Returns the number of
+ * bytes consumed; *written receives the number of bytes produced. */
+static size_t foldChar(const unsigned char *text, size_t length,
+                       unsigned char *out, size_t *written) {
+  uint32_t codePoint;
+  size_t size = decodeUtf8(text, length, &codePoint);
+  if (codePoint == UINT32_MAX) {
+    out[0] = text[0];
+    *written = 1;
+  } else {
+    *written = encodeUtf8(foldCodePoint(codePoint), out);
+  }
+  return size;
+}
+
+/* Returns the byte length of the character at text, at least 1. */
+size_t utf8CharLength(const unsigned char *text, size_t length) {
+  uint32_t codePoint;
+  return length == 0 ? 1 : decodeUtf8(text, length, &codePoint);
+}
+
+/* Folds a line. ASCII spans go through the lookup table; only non-ASCII
+ * characters are decoded. Offsets are tracked once the lengths diverge. */
+int foldLine(FoldBuffer *fold, const char *line, size_t length) {
+  const unsigned char *source = (const unsigned char *)line;
+  /* A folded character is at most twice as long as the original. */
+  size_t needed = length * 2 + 1;
+  if (needed > fold->capacity) {
+    char *text = (char *)realloc(fold->text, needed);
+    if (text != NULL) {
+      fold->text = text;
+    }
+    size_t *offsets =
+        (size_t *)realloc(fold->offsets, needed * sizeof(size_t));
+    if (offsets != NULL) {
+      fold->offsets = offsets;
+    }
+    if (text == NULL || offsets == NULL) {
+      return 0;
+    }
+    fold->capacity = needed;
+  }
+
+  unsigned char *target = (unsigned char *)fold->text;
+  size_t in = 0;
+  size_t out = 0;
+  fold->isIdentity = 1;
+  while (in < length) {
+    size_t asciiEnd = in + asciiPrefixLength(source + in, length - in);
+    if (fold->isIdentity) {
+      for (; in < asciiEnd; in++, out++) {
+        target[out] = asciiFold[source[in]];
+      }
+    } else {
+      for (; in < asciiEnd; in++, out++) {
+        target[out] = asciiFold[source[in]];
+        fold->offsets[out] = in;
+      }
+    }
+    if (in < length) {
+      size_t written;
+      size_t consumed = foldChar(source + in, length - in, target + out,
+                                 &written);
+      if (fold->isIdentity && written != consumed) {
+        for (size_t i = 0; i < out; i++) {
+          fold->offsets[i] = i;
+        }
+        fold->isIdentity = 0;
+      }
+      if (!fold->isIdentity) {
+        for (size_t i = 0; i < written; i++) {
+          fold->offsets[out + i] = in;
+        }
+      }
+      in += consumed;
+      out += written;
+    }
+  }
+  if (!fold->isIdentity) {
+    fold->offsets[out] = length;
+  }
+  target[out] = '\0';
+  fold->length = out;
+  return 1;
+}
+
+/* Folds one pattern character, advancing both positions. */
+static void foldPatternChar(const unsigned char *source, size_t length,
+                            size_t *in, unsigned char *folded, size_t *out) {
+  if (source[*in] < 0x80) {
+    folded[(*out)++] = asciiFold[source[(*in)++]];
+  } else {
+    size_t written;
+    *in += foldChar(source + *in, length - *in, folded + *out, &written);
+    *out += written;
+  }
+}
+
+/* Folds a bracket expression starting at '['. A backslash is literal inside
+ * brackets, so every character is folded. Class names are copied, except
+ * that [:upper:] becomes [:lower:] since folded text has no upper case.
+ * A single character in [=x=] or [.x.] is folded like any other. */
+static void foldBracket(const unsigned char *source, size_t length,
+                        size_t *in, unsigned char *folded, size_t *out) {
+  folded[(*out)++] = source[(*in)++];
+  if (*in < length && source[*in] == '^') {
+    folded[(*out)++] = source[(*in)++];
+  }
+  if (*in < length && source[*in] == ']') {
+    folded[(*out)++] = source[(*in)++];
+  }
+
+  while (*in < length && source[*in] != ']') {
+    size_t close = length;
+    if (source[*in] == '[' && *in + 1 < length &&
+        (source[*in + 1] == ':' || source[*in + 1] == '=' ||
+         source[*in + 1] == '.')) {
+      for (size_t i = *in + 2; i + 1 < length && close == length; i++) {
+        if (source[i] == source[*in + 1] && source[i + 1] == ']') {
+          close = i;
+        }
+      }
+    }
+    if (close == length) {
+      foldPatternChar(source, length, in, folded, out);
+    } else if (close - *in == 7 &&
+               memcmp(source + *in, "[:upper:", 8) == 0) {
+      memcpy(folded + *out, "[:lower:]", 9);
+      *in += 9;
+      *out += 9;
+    } else if (source[*in + 1] != ':' && close > *in + 2 &&
+               utf8CharLength(source + *in + 2, close - *in - 2) ==
+                   close - *in - 2) {
+      folded[(*out)++] = source[(*in)++];
+      folded[(*out)++] = source[(*in)++];
+      foldPatternChar(source, close, in, folded, out);
+      folded[(*out)++] = source[(*in)++];
+      folded[(*out)++] = source[(*in)++];
+    } else {
+      memcpy(folded + *out, source + *in, close + 2 - *in);
+      *out += close + 2 - *in;
+      *in = close + 2;
+    }
+  }
+  if (*in < length) {
+    folded[(*out)++] = source[(*in)++];
+  }
+}
+
+/* Folds a regular expression the same way as the text it is matched
+ * against. Outside brackets the GNU escapes keep their case so that '\W'
+ * stays '\W'; any other escaped character is a literal and is folded. */
+char *foldPattern(const char *pattern) {
+  const unsigned char *source = (const unsigned char *)pattern;
+  size_t length = strlen(pattern);
+  unsigned char *folded = (unsigned char *)malloc(length * 2 + 1);
+  if (folded == NULL) {
+    return NULL;
+  }
+
+  size_t in = 0;
+  size_t out = 0;
+  while (in < length) {
+    if (source[in] == '\\' && in + 1 < length) {
+      folded[out++] = source[in++];
+      if (strchr("wWsSbB<>`'", source[in]) != NULL) {
+        folded[out++] = source[in++];
+      } else {
+        foldPatternChar(source, length, &in, folded, &out);
+      }
+    } else if (source[in] == '[') {
+      foldBracket(source, length, &in, folded, &out);
+    } else {
+      foldPatternChar(source, length, &in, folded, &out);
+    }
+  }
+  folded[out] = '\0';
+  return (char *)folded;
+}
+
+/* Maps an offset in the folded text back to the original line. */
+size_t originalOffset(const FoldBuffer *fold, size_t offset) {
+  return fold->isIdentity ? offset : fold->offsets[offset];
+}
+
+/* Frees the memory held by a fold buffer. */
+void freeFoldBuffer(FoldBuffer *fold) {
+  free(fold->text);
+  free(fold->offsets);
+  fold->text = NULL;
+  fold->offsets = NULL;
+  fold->capacity = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef S21_GREP_FOLD_H
+#define S21_GREP_FOLD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Range of code points folded by a constant delta. With a step of 2 only
+ * every other code point (the upper-case half of a pair) is folded. */
+typedef struct {
+  uint32_t first; /* First code point of the range. */
+  uint32_t last;  /* Last code point of the range. */
+  int32_t delta;  /* Added to fold a code point. */
+  uint32_t step;  /* 1 for contiguous ranges, 2 for alternating pairs. */
+} FoldRange;
+
+/* Case-folded copy of a line used for '-i' matching. */
+typedef struct {
+  char *text;       /* Folded text, NUL-terminated. */
+  size_t length;    /* Length of the folded text. */
+  size_t capacity;  /* Allocated size of text and offsets. */
+  size_t *offsets;  /* Folded offset -> original offset, for non-ASCII. */
+  int isIdentity;   /* Folded offsets equal original offsets. */
+} FoldBuffer;
+
+/* Function prototypes. */
+size_t asciiPrefixLength(const unsigned char *text, size_t length);
+size_t utf8CharLength(const unsigned char *text, size_t length);
+int foldLine(FoldBuffer *fold, const char *line, size_t length);
+char *foldPattern(const char *pattern);
+size_t originalOffset(const FoldBuffer *fold, size_t offset);
+void freeFoldBuffer(FoldBuffer *fold);
+
+#endif /* S21_GREP_FOLD_H */
@@ -30,6 +30,9 @@ echo -e "This is a test file.\nTest line.\nAnother test line.\n" > "$TEST_DIR/te
 echo -e "Line1\nLine2\nLine3\nLine4\nLine5" > "$TEST_DIR/test2.txt"
 echo -e "12345\nabcde\nABCDE\n!@#$%\n" > "$TEST_DIR/test3.txt"
 echo -e "Pattern matching test.\npattern matching test.\nPattern Matching Test." > "$TEST_DIR/test4.txt"
+echo -e "user ÉLODIE logged in\nuser élodie\nLOGIN Élodie ok\nadmin ȘTEFAN took 5µs" > "$TEST_DIR/test5.txt"
+printf 'A\na\n\\\n' > "$TEST_DIR/test6.txt"
+echo -e "Ö\nxéy\nÖY x-y" > "$TEST_DIR/test7.txt"
 echo -e "Empty file for testing." > "$TEST_DIR/empty.txt"
 touch "$TEST_DIR/nonexistent.txt"  # Will be used to simulate a nonexistent file
 
@@ -57,6 +60,8 @@ declare -a tests=(
     "-iv 'line' $TEST_DIR/test1.txt"
     "-in 'Line' $TEST_DIR/test2.txt"
     "-o 'Line' $TEST_DIR/test2.txt"
+    "-on 'e' $TEST_DIR/test4.txt"
+    "-o '^L' $TEST_DIR/test2.txt"
     # Edge cases
     "-e '' $TEST_DIR/test1.txt"  # Empty pattern
     "-f $TEST_DIR/nonexistent.txt $TEST_DIR/test1.txt"  # Nonexistent pattern file
@@ -74,10 +79,32 @@ declare -a tests=(
     "-s 'test' $TEST_DIR/nonexistent_file.txt"
 )
 
+# UTF-8 folding must not depend on the locale grep runs in: compare with
+# every case variant spelled out
+declare -a utf8_tests=(
+    "-i 'élodie' $TEST_DIR/test5.txt|-e 'ÉLODIE' -e 'élodie' -e 'Élodie' $TEST_DIR/test5.txt"
+    "-io 'ÉLODIE' $TEST_DIR/test5.txt|-o -e 'ÉLODIE' -e 'élodie' -e 'Élodie' $TEST_DIR/test5.txt"
+    # Brackets and '.' match whole characters, not bytes: [ÀY] shares its
+    # lead byte with Ö but must not match it
+    "-o '[ÀY]+' $TEST_DIR/test7.txt|-o 'Y' $TEST_DIR/test7.txt"
+    "-on 'x.y' $TEST_DIR/test7.txt|-on -e 'xéy' -e 'x-y' $TEST_DIR/test7.txt"
+    "-io 'X.Y' $TEST_DIR/test7.txt|-o -e 'xéy' -e 'x-y' $TEST_DIR/test7.txt"
+    # Escaped literals fold, GNU escapes such as \W do not
+    "-i '\\ö' $TEST_DIR/test7.txt|-e 'Ö' $TEST_DIR/test7.txt"
+    "-i '\\A' $TEST_DIR/test6.txt|-e '[Aa]' $TEST_DIR/test6.txt"
+    "-io 'y\\WX' $TEST_DIR/test7.txt|-o 'Y x' $TEST_DIR/test7.txt"
+    "-io 'ștefan' $TEST_DIR/test5.txt|-o -e 'ȘTEFAN' -e 'ștefan' $TEST_DIR/test5.txt"
+    "-i '5μs' $TEST_DIR/test5.txt|-e '5µs' $TEST_DIR/test5.txt"
+    # A backslash is literal inside brackets, everything there is folded
+    "-i '[\\A]' $TEST_DIR/test6.txt|-e '' $TEST_DIR/test6.txt"
+    "-i '^[[:upper:]]' $TEST_DIR/test6.txt|-e '^[Aa]' $TEST_DIR/test6.txt"
+    "-io '[^[:upper:]]' $TEST_DIR/test6.txt|-o '[^Aa]' $TEST_DIR/test6.txt"
+)
+
 # Function to run a test case
 run_test() {
     local test_command="$1"
-    local grep_command="$GREP $test_command"
+    local grep_command="$GREP ${2:-$test_command}"
     local s21_grep_command="$S21_GREP $test_command"
 
     # Run the commands and capture outputs
@@ -110,6 +137,9 @@ run_test() {
 for test_case in "${tests[@]}"; do
     run_test "$test_case"
 done
+for test_case in "${utf8_tests[@]}"; do
+    run_test "${test_case%%|*}" "${test_case#*|}"
+done
 
 # Summary
 echo -e "\n========================================"